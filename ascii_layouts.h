@@ -0,0 +1,114 @@
+#ifndef ASCII_LAYOUTS_H
+#define ASCII_LAYOUTS_H
+
+// How to type each ASCII character on the host layouts we support.
+//
+// Every layout is a list of X(character, keycode, modifier class) entries.
+// keymap.c expands them into one packed word per character (keycode in the
+// low byte, modifier class in the high byte). SEND_STRING and the HS_*
+// symbol keys both type through that table. ascii_layouts_verify.c types
+// every entry on a simulated host layout to check they round trip, and
+// rules.mk runs it on every build.
+// Characters that are not listed are sent as KC_NO.
+
+#define AL_NONE  0
+#define AL_SHIFT 1 // hold Shift
+#define AL_ALTGR 2 // hold right Alt (AltGr on PC, Option on Mac)
+#define AL_DEAD  4 // dead key, follow with a space
+
+// clang-format off
+
+#define ASCII_LAYOUT_CONTROL(X) \
+    X('\b', KC_BSPC, AL_NONE) \
+    X('\t', KC_TAB,  AL_NONE) \
+    X('\n', KC_ENT,  AL_NONE) \
+    X(0x1B, KC_ESC,  AL_NONE) \
+    X(' ',  KC_SPC,  AL_NONE) \
+    X(0x7F, KC_DEL,  AL_NONE)
+
+#define ASCII_LAYOUT_ALNUM(X) \
+    X('0', SE_0, AL_NONE)  X('1', SE_1, AL_NONE)  X('2', SE_2, AL_NONE) \
+    X('3', SE_3, AL_NONE)  X('4', SE_4, AL_NONE)  X('5', SE_5, AL_NONE) \
+    X('6', SE_6, AL_NONE)  X('7', SE_7, AL_NONE)  X('8', SE_8, AL_NONE) \
+    X('9', SE_9, AL_NONE) \
+    X('a', SE_A, AL_NONE)  X('A', SE_A, AL_SHIFT) \
+    X('b', SE_B, AL_NONE)  X('B', SE_B, AL_SHIFT) \
+    X('c', SE_C, AL_NONE)  X('C', SE_C, AL_SHIFT) \
+    X('d', SE_D, AL_NONE)  X('D', SE_D, AL_SHIFT) \
+    X('e', SE_E, AL_NONE)  X('E', SE_E, AL_SHIFT) \
+    X('f', SE_F, AL_NONE)  X('F', SE_F, AL_SHIFT) \
+    X('g', SE_G, AL_NONE)  X('G', SE_G, AL_SHIFT) \
+    X('h', SE_H, AL_NONE)  X('H', SE_H, AL_SHIFT) \
+    X('i', SE_I, AL_NONE)  X('I', SE_I, AL_SHIFT) \
+    X('j', SE_J, AL_NONE)  X('J', SE_J, AL_SHIFT) \
+    X('k', SE_K, AL_NONE)  X('K', SE_K, AL_SHIFT) \
+    X('l', SE_L, AL_NONE)  X('L', SE_L, AL_SHIFT) \
+    X('m', SE_M, AL_NONE)  X('M', SE_M, AL_SHIFT) \
+    X('n', SE_N, AL_NONE)  X('N', SE_N, AL_SHIFT) \
+    X('o', SE_O, AL_NONE)  X('O', SE_O, AL_SHIFT) \
+    X('p', SE_P, AL_NONE)  X('P', SE_P, AL_SHIFT) \
+    X('q', SE_Q, AL_NONE)  X('Q', SE_Q, AL_SHIFT) \
+    X('r', SE_R, AL_NONE)  X('R', SE_R, AL_SHIFT) \
+    X('s', SE_S, AL_NONE)  X('S', SE_S, AL_SHIFT) \
+    X('t', SE_T, AL_NONE)  X('T', SE_T, AL_SHIFT) \
+    X('u', SE_U, AL_NONE)  X('U', SE_U, AL_SHIFT) \
+    X('v', SE_V, AL_NONE)  X('V', SE_V, AL_SHIFT) \
+    X('w', SE_W, AL_NONE)  X('W', SE_W, AL_SHIFT) \
+    X('x', SE_X, AL_NONE)  X('X', SE_X, AL_SHIFT) \
+    X('y', SE_Y, AL_NONE)  X('Y', SE_Y, AL_SHIFT) \
+    X('z', SE_Z, AL_NONE)  X('Z', SE_Z, AL_SHIFT)
+
+// Punctuation that is on the same key with the same modifiers on both hosts.
+#define ASCII_LAYOUT_SWEDISH_COMMON(X) \
+    ASCII_LAYOUT_CONTROL(X) \
+    ASCII_LAYOUT_ALNUM(X) \
+    X('!',  SE_1,    AL_SHIFT) \
+    X('"',  SE_2,    AL_SHIFT) \
+    X('#',  SE_3,    AL_SHIFT) \
+    X('$',  SE_4,    AL_ALTGR) \
+    X('%',  SE_5,    AL_SHIFT) \
+    X('&',  SE_6,    AL_SHIFT) \
+    X('\'', SE_QUOT, AL_NONE) \
+    X('(',  SE_8,    AL_SHIFT) \
+    X(')',  SE_9,    AL_SHIFT) \
+    X('*',  SE_QUOT, AL_SHIFT) \
+    X('+',  SE_PLUS, AL_NONE) \
+    X(',',  SE_COMM, AL_NONE) \
+    X('-',  SE_MINS, AL_NONE) \
+    X('.',  SE_DOT,  AL_NONE) \
+    X('/',  SE_7,    AL_SHIFT) \
+    X(':',  SE_DOT,  AL_SHIFT) \
+    X(';',  SE_COMM, AL_SHIFT) \
+    X('=',  SE_0,    AL_SHIFT) \
+    X('?',  SE_PLUS, AL_SHIFT) \
+    X('@',  SE_2,    AL_ALTGR) \
+    X('[',  SE_8,    AL_ALTGR) \
+    X(']',  SE_9,    AL_ALTGR) \
+    X('^',  SE_DIAE, AL_SHIFT | AL_DEAD) \
+    X('_',  SE_MINS, AL_SHIFT) \
+    X('`',  SE_ACUT, AL_SHIFT | AL_DEAD) \
+    X('~',  SE_DIAE, AL_ALTGR | AL_DEAD)
+
+#define ASCII_LAYOUT_SWEDISH_MAC_ISO(X) \
+    ASCII_LAYOUT_SWEDISH_COMMON(X) \
+    X('<',  SE_LABK, AL_NONE) \
+    X('>',  SE_LABK, AL_SHIFT) \
+    X('\\', SE_7,    AL_SHIFT | AL_ALTGR) \
+    X('{',  SE_8,    AL_SHIFT | AL_ALTGR) \
+    X('|',  SE_7,    AL_ALTGR) \
+    X('}',  SE_9,    AL_SHIFT | AL_ALTGR)
+
+// keymap_swedish.h cannot be included next to keymap_swedish_mac_iso.h, so
+// the < > | key is spelled KC_NUBS here.
+#define ASCII_LAYOUT_SWEDISH_PC(X) \
+    ASCII_LAYOUT_SWEDISH_COMMON(X) \
+    X('<',  KC_NUBS, AL_NONE) \
+    X('>',  KC_NUBS, AL_SHIFT) \
+    X('\\', SE_PLUS, AL_ALTGR) \
+    X('{',  SE_7,    AL_ALTGR) \
+    X('|',  KC_NUBS, AL_ALTGR) \
+    X('}',  SE_0,    AL_ALTGR)
+
+// clang-format on
+
+#endif // ASCII_LAYOUTS_H
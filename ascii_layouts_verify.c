@@ -0,0 +1,185 @@
+/*
+ * Host side check of ascii_layouts.h. Not part of the firmware. rules.mk
+ * builds and runs it with the host cc on every firmware build. To run it
+ * by hand:
+ *
+ *   cc -o ascii_layouts_verify ascii_layouts_verify.c && ./ascii_layouts_verify
+ *
+ * Each layout is typed on a simulated host keyboard layout (including dead
+ * keys) and every printable ASCII character has to come back out unchanged.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+// Physical keys, named like the firmware keycodes so the layout
+// descriptions can be expanded as is.
+enum sim_key {
+    KC_NO,
+    KC_BSPC, KC_TAB, KC_ENT, KC_ESC, KC_SPC, KC_DEL, KC_NUBS,
+    SE_A, SE_B, SE_C, SE_D, SE_E, SE_F, SE_G, SE_H, SE_I, SE_J, SE_K, SE_L, SE_M,
+    SE_N, SE_O, SE_P, SE_Q, SE_R, SE_S, SE_T, SE_U, SE_V, SE_W, SE_X, SE_Y, SE_Z,
+    SE_0, SE_1, SE_2, SE_3, SE_4, SE_5, SE_6, SE_7, SE_8, SE_9,
+    SE_PLUS, SE_ACUT, SE_DIAE, SE_QUOT, SE_LABK, SE_COMM, SE_DOT, SE_MINS,
+    SIM_KEY_COUNT
+};
+
+#include "ascii_layouts.h"
+
+#define LEGEND(mods) ((mods) & (AL_SHIFT | AL_ALTGR))
+
+typedef struct {
+    char legend[4]; // indexed by LEGEND(), 0 for anything that is not ASCII
+    char dead;      // bit per legend index
+} sim_key_t;
+
+// Only the ASCII legends matter, e.g. Shift+4 (€) is left out.
+static sim_key_t swedish_mac_iso[SIM_KEY_COUNT] = {
+    [KC_BSPC] = {{'\b'}},
+    [KC_TAB]  = {{'\t'}},
+    [KC_ENT]  = {{'\n'}},
+    [KC_ESC]  = {{0x1B}},
+    [KC_SPC]  = {{' '}},
+    [KC_DEL]  = {{0x7F}},
+    [SE_0]    = {{'0', '='}},
+    [SE_1]    = {{'1', '!'}},
+    [SE_2]    = {{'2', '"', '@'}},
+    [SE_3]    = {{'3', '#'}},
+    [SE_4]    = {{'4', 0, '$'}},
+    [SE_5]    = {{'5', '%'}},
+    [SE_6]    = {{'6', '&'}},
+    [SE_7]    = {{'7', '/', '|', '\\'}},
+    [SE_8]    = {{'8', '(', '[', '{'}},
+    [SE_9]    = {{'9', ')', ']', '}'}},
+    [SE_PLUS] = {{'+', '?'}},
+    [SE_ACUT] = {{0, '`'}, 1 << AL_SHIFT},
+    [SE_DIAE] = {{0, '^', '~'}, 1 << AL_SHIFT | 1 << AL_ALTGR},
+    [SE_QUOT] = {{'\'', '*'}},
+    [SE_LABK] = {{'<', '>'}},
+    [SE_COMM] = {{',', ';'}},
+    [SE_DOT]  = {{'.', ':'}},
+    [SE_MINS] = {{'-', '_'}},
+};
+
+static sim_key_t swedish_pc[SIM_KEY_COUNT] = {
+    [KC_BSPC] = {{'\b'}},
+    [KC_TAB]  = {{'\t'}},
+    [KC_ENT]  = {{'\n'}},
+    [KC_ESC]  = {{0x1B}},
+    [KC_SPC]  = {{' '}},
+    [KC_DEL]  = {{0x7F}},
+    [KC_NUBS] = {{'<', '>', '|'}},
+    [SE_0]    = {{'0', '=', '}'}},
+    [SE_1]    = {{'1', '!'}},
+    [SE_2]    = {{'2', '"', '@'}},
+    [SE_3]    = {{'3', '#'}},
+    [SE_4]    = {{'4', 0, '$'}},
+    [SE_5]    = {{'5', '%'}},
+    [SE_6]    = {{'6', '&'}},
+    [SE_7]    = {{'7', '/', '{'}},
+    [SE_8]    = {{'8', '(', '['}},
+    [SE_9]    = {{'9', ')', ']'}},
+    [SE_PLUS] = {{'+', '?', '\\'}},
+    [SE_ACUT] = {{0, '`'}, 1 << AL_SHIFT},
+    [SE_DIAE] = {{0, '^', '~'}, 1 << AL_SHIFT | 1 << AL_ALTGR},
+    [SE_QUOT] = {{'\'', '*'}},
+    [SE_COMM] = {{',', ';'}},
+    [SE_DOT]  = {{'.', ':'}},
+    [SE_MINS] = {{'-', '_'}},
+};
+
+typedef struct {
+    char     ch;
+    int      keycode;
+    unsigned mods;
+} entry_t;
+
+#define ENTRY(ch, kc, mods) {(ch), (kc), (mods)},
+
+static const entry_t mac_entries[] = {ASCII_LAYOUT_SWEDISH_MAC_ISO(ENTRY)};
+static const entry_t pc_entries[]  = {ASCII_LAYOUT_SWEDISH_PC(ENTRY)};
+
+static void add_letters(sim_key_t *layout) {
+    for (int i = 0; i < 26; i++) {
+        layout[SE_A + i].legend[0] = 'a' + i;
+        layout[SE_A + i].legend[1] = 'A' + i;
+    }
+}
+
+// Types one key the way host_send_char does and returns what the host
+// would have produced, at most two characters.
+static int type_key(const sim_key_t *layout, const entry_t *e, char *out) {
+    const sim_key_t *key     = &layout[e->keycode];
+    int              legend  = LEGEND(e->mods);
+    int              n       = 0;
+    char             pending = 0;
+
+    if (key->dead & (1 << legend)) {
+        pending = key->legend[legend];
+    } else if (key->legend[legend]) {
+        out[n++] = key->legend[legend];
+    }
+    if (e->mods & AL_DEAD) {
+        if (pending) {
+            out[n++] = pending;
+            pending  = 0;
+        } else {
+            out[n++] = ' ';
+        }
+    }
+    // A dead key that is never completed swallows the next character.
+    return pending ? -1 : n;
+}
+
+static int verify(const char *name, const sim_key_t *layout, const entry_t *entries, size_t count) {
+    const entry_t *seen[128] = {0};
+    int            errors    = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const entry_t *e = &entries[i];
+        unsigned char  c = (unsigned char)e->ch;
+        char           out[2];
+        int            n;
+
+        if (c > 127) {
+            printf("%s: 0x%02X is not ASCII\n", name, c);
+            errors++;
+            continue;
+        }
+        if (seen[c]) {
+            printf("%s: 0x%02X is listed twice\n", name, c);
+            errors++;
+        }
+        seen[c] = e;
+
+        n = type_key(layout, e, out);
+        if (n < 0) {
+            printf("%s: 0x%02X leaves a dead key pending\n", name, c);
+            errors++;
+        } else if (n != 1 || out[0] != e->ch) {
+            printf("%s: 0x%02X types \"%.*s\"\n", name, c, n, out);
+            errors++;
+        }
+    }
+    for (int c = 0x20; c < 0x7F; c++) {
+        if (!seen[c]) {
+            printf("%s: '%c' is missing\n", name, c);
+            errors++;
+        }
+    }
+
+    printf("%s: %zu characters, %d errors\n", name, count, errors);
+    return errors;
+}
+
+int main(void) {
+    int errors = 0;
+
+    add_letters(swedish_mac_iso);
+    add_letters(swedish_pc);
+
+    errors += verify("Swedish Mac ISO", swedish_mac_iso, mac_entries, sizeof(mac_entries) / sizeof(mac_entries[0]));
+    errors += verify("Swedish PC", swedish_pc, pc_entries, sizeof(pc_entries) / sizeof(pc_entries[0]));
+
+    return errors ? 1 : 0;
+}
@@ -3,4 +3,8 @@
 
 #define TAPPING_TOGGLE 2
 
+// Count layer switches and time per layer, printed by the Layer stats key.
+// Needs CONSOLE_ENABLE = yes in rules.mk.
+// #define LAYER_METRICS_ENABLE
+
 #endif // CONFIG_PER_H
\ No newline at end of file
@@ -19,118 +19,20 @@
 #include "action_tapping.h"
 #include "debug.h"
 #include "keymap_swedish_mac_iso.h"
+#include "ascii_layouts.h"
 // #include "sendstring_swedish.h"
 // #include "sendstring_swedish_mac_iso.h"
 
 #include "quantum.h"
 
-// clang-format off
-
-const uint8_t ascii_to_shift_lut[16] PROGMEM = {
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 1, 1, 1, 0, 1, 1, 0),
-    KCLUT_ENTRY(1, 1, 1, 0, 0, 0, 0, 1),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 1, 1, 0, 1, 1, 1),
-    KCLUT_ENTRY(0, 1, 1, 1, 1, 1, 1, 1),
-    KCLUT_ENTRY(1, 1, 1, 1, 1, 1, 1, 1),
-    KCLUT_ENTRY(1, 1, 1, 1, 1, 1, 1, 1),
-    KCLUT_ENTRY(1, 1, 1, 0, 0, 0, 1, 1),
-    KCLUT_ENTRY(1, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0)
-};
-
-const uint8_t ascii_to_altgr_lut[16] PROGMEM = {
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-
-    KCLUT_ENTRY(0, 0, 0, 0, 1, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(1, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 1, 1, 1, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 1, 1, 1, 1, 0)
-};
-
-const uint8_t ascii_to_dead_lut[16] PROGMEM = {
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 1, 0),
-    KCLUT_ENTRY(1, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),
-    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 1, 0)
-};
-
-const uint8_t ascii_to_keycode_lut[128] PROGMEM = {
-    // NUL   SOH      STX      ETX      EOT      ENQ      ACK      BEL
-    XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
-    // BS    TAB      LF       VT       FF       CR       SO       SI
-    KC_BSPC, KC_TAB,  KC_ENT,  XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
-    // DLE   DC1      DC2      DC3      DC4      NAK      SYN      ETB
-    XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
-    // CAN   EM       SUB      ESC      FS       GS       RS       US
-    XXXXXXX, XXXXXXX, XXXXXXX, KC_ESC,  XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
-
-    //       !        "        #        $        %        &        '
-    KC_SPC,  SE_1,    SE_2,    SE_3,    SE_4,    SE_5,    SE_6,    SE_QUOT,
-    // (     )        *        +        ,        -        .        /
-    SE_8,    SE_9,    SE_QUOT, SE_PLUS, SE_COMM, SE_MINS, SE_DOT,  SE_7,
-    // 0     1        2        3        4        5        6        7
-    SE_0,    SE_1,    SE_2,    SE_3,    SE_4,    SE_5,    SE_6,    SE_7,
-    // 8     9        :        ;        <        =        >        ?
-    SE_8,    SE_9,    SE_DOT,  SE_COMM, SE_LABK, SE_0,    SE_LABK, SE_PLUS,
-    // @     A        B        C        D        E        F        G
-    SE_2,    SE_A,    SE_B,    SE_C,    SE_D,    SE_E,    SE_F,    SE_G,
-    // H     I        J        K        L        M        N        O
-    SE_H,    SE_I,    SE_J,    SE_K,    SE_L,    SE_M,    SE_N,    SE_O,
-    // P     Q        R        S        T        U        V        W
-    SE_P,    SE_Q,    SE_R,    SE_S,    SE_T,    SE_U,    SE_V,    SE_W,
-    // X     Y        Z        [        \        ]        ^        _
-    SE_X,    SE_Y,    SE_Z,    SE_8,    SE_PLUS, SE_9,    SE_DIAE, SE_MINS,
-    // `     a        b        c        d        e        f        g
-    SE_ACUT, SE_A,    SE_B,    SE_C,    SE_D,    SE_E,    SE_F,    SE_G,
-    // h     i        j        k        l        m        n        o
-    SE_H,    SE_I,    SE_J,    SE_K,    SE_L,    SE_M,    SE_N,    SE_O,
-    // p     q        r        s        t        u        v        w
-    SE_P,    SE_Q,    SE_R,    SE_S,    SE_T,    SE_U,    SE_V,    SE_W,
-    // x     y        z        {        |        }        ~        DEL
-    SE_X,    SE_Y,    SE_Z,    SE_7,    SE_LABK, SE_0,    SE_DIAE, KC_DEL
-};
-
 #define BASE 0 // default layer
 #define SYMB 1 // symbols
 #define MDIA 2 // media keys
 #define PROG 3 // programming keys
 #define VIM  4 // vim like keys
+#define LAYER_COUNT 5
 #define TAPPING_TERM_PER_KEY
 
-// #undef TAPPING_TOGGLE
-// #define TAPPING_TOGGLE 2
-
 uint8_t mod_state;
 
 enum custom_keycodes {
@@ -141,8 +43,143 @@ enum custom_keycodes {
   PE_RARR,
   PE_LEAR,
   PE_REAR,
+  HOST_OS,  // cycles the host profile, see host_profiles
+#ifdef LAYER_METRICS_ENABLE
+  LAYER_STATS, // prints the layer metrics, see layer_state_set_user
+#endif
+  // Symbols that sit on different keys depending on the host OS.
+  HS_DLR,
+  HS_LBRC,
+  HS_RBRC,
+  HS_LCBR,
+  HS_RCBR,
+  HS_BSLS,
+  HS_PIPE,
+  HS_TILD,
+  HS_LABK,
+  HS_RABK,
+  HS_END
+};
+
+#ifndef LAYER_METRICS_ENABLE
+#define LAYER_STATS KC_TRNS
+#endif
+
+#define HOST_SYMBOL(kc) ((kc) - HS_DLR)
+#define HOST_SYMBOL_COUNT HOST_SYMBOL(HS_END)
+
+// Host profiles. Everything that depends on the OS keyboard layout of the
+// machine we are plugged into lives in one PROGMEM struct per host, so
+// switching hosts is a single pointer swap.
+enum host_os {
+  HOST_MAC, // Swedish Mac ISO
+  HOST_PC,  // Swedish (Linux/Windows)
+  HOST_COUNT
+};
+
+typedef struct {
+  uint16_t ascii[128]; // keycode | modifier class << 8, see ascii_layouts.h
+} host_profile_t;
+
+typedef union {
+  uint32_t raw;
+  struct {
+    uint8_t host_os :2;
+  };
+} user_config_t;
+
+user_config_t user_config;
+
+#define ASCII_ENTRY(ch, kc, mods) [(uint8_t)(ch)] = (kc) | (mods) << 8,
+
+// clang-format off
+
+static const host_profile_t host_profiles[HOST_COUNT] PROGMEM = {
+[HOST_MAC] = {
+  .ascii = { ASCII_LAYOUT_SWEDISH_MAC_ISO(ASCII_ENTRY) },
+},
+[HOST_PC] = {
+  .ascii = { ASCII_LAYOUT_SWEDISH_PC(ASCII_ENTRY) },
+},
 };
 
+// clang-format on
+
+static const host_profile_t *host_profile = &host_profiles[HOST_MAC];
+
+// The character each HS_* key types, looked up in the host's ascii table.
+static const char host_symbols[HOST_SYMBOL_COUNT] PROGMEM = {
+    [HOST_SYMBOL(HS_DLR)]  = '$',
+    [HOST_SYMBOL(HS_LBRC)] = '[',
+    [HOST_SYMBOL(HS_RBRC)] = ']',
+    [HOST_SYMBOL(HS_LCBR)] = '{',
+    [HOST_SYMBOL(HS_RCBR)] = '}',
+    [HOST_SYMBOL(HS_BSLS)] = '\\',
+    [HOST_SYMBOL(HS_PIPE)] = '|',
+    [HOST_SYMBOL(HS_TILD)] = '~',
+    [HOST_SYMBOL(HS_LABK)] = '<',
+    [HOST_SYMBOL(HS_RABK)] = '>',
+};
+
+// The ascii entry each HS_* key registered on press, so a profile switch
+// while it is held still releases the same keys.
+static uint16_t held_symbols[HOST_SYMBOL_COUNT];
+
+static void set_host_os(uint8_t host_os) {
+    if (host_os >= HOST_COUNT) {
+        host_os = HOST_MAC;
+    }
+    host_profile = &host_profiles[host_os];
+    user_config.host_os = host_os;
+}
+
+static void register_ascii_entry(uint16_t entry) {
+    if (entry & AL_SHIFT << 8) {
+        register_code(KC_LSFT);
+    }
+    if (entry & AL_ALTGR << 8) {
+        register_code(KC_RALT);
+    }
+    register_code(entry & 0xFF);
+}
+
+static void unregister_ascii_entry(uint16_t entry) {
+    unregister_code(entry & 0xFF);
+    if (entry & AL_ALTGR << 8) {
+        unregister_code(KC_RALT);
+    }
+    if (entry & AL_SHIFT << 8) {
+        unregister_code(KC_LSFT);
+    }
+    if (entry & AL_DEAD << 8) {
+        tap_code(KC_SPACE);
+    }
+}
+
+// Same as QMK's send_char, but reading the table of the active host profile.
+static void host_send_char(char ascii_code) {
+    uint8_t c = (uint8_t)ascii_code;
+    if (c > 127) {
+        return;
+    }
+
+    uint16_t entry = pgm_read_word(&host_profile->ascii[c]);
+    register_ascii_entry(entry);
+    unregister_ascii_entry(entry);
+}
+
+static void host_send_string_P(const char *str) {
+    char ascii_code;
+    while ((ascii_code = pgm_read_byte(str++))) {
+        host_send_char(ascii_code);
+    }
+}
+
+// Route SEND_STRING through the host profile instead of the global LUTs.
+#undef SEND_STRING
+#define SEND_STRING(string) host_send_string_P(PSTR(string))
+
+// clang-format off
 const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 /* Keymap 0: Basic layer
  *
@@ -176,11 +213,11 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
     KC_LSFT,         KC_Z,     KC_X,     KC_C,    KC_V,    KC_B,                    TT(VIM),
     KC_LCTRL,  SE_CIRC,  SE_ASTR,  KC_LALT, KC_LGUI,
                                                KC_LCTRL,  KC_LALT,
-                                                          SE_TILD,
-                                         LT(SYMB, KC_ENTER), KC_ENTER, SE_BSLS,
+                                                          HS_TILD,
+                                         LT(SYMB, KC_ENTER), KC_ENTER, HS_BSLS,
     // right hand
 
-         SE_TILD,   KC_6,   KC_7,  KC_8,    KC_9,    KC_0,     KC_BSPC,
+         HS_TILD,   KC_6,   KC_7,  KC_8,    KC_9,    KC_0,     KC_BSPC,
          KC_ENTER,  KC_Y,   KC_U, KC_I,    KC_O,    KC_P,     SE_ARNG,
                     KC_H,   KC_J, KC_K,    RALT_T(KC_L),    SE_ODIA,  SE_ADIA,
          TO(SYMB),    KC_N,   LT(MDIA, KC_M)       , KC_COMM, KC_DOT,  SE_MINS,  KC_RSFT,
@@ -237,7 +274,8 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 /* Keymap 2: Media and mouse keys
  *
  * ,--------------------------------------------------.           ,--------------------------------------------------.
- * |        |      |      |      |      |      |      |           |      |      |      |      |      |      |        |
+ * |        |      |      |      |      | Host |Layer |           |      |      |      |      |      |      |        |
+ * |        |      |      |      |      |  OS  |stats |           |      |      |      |      |      |      |        |
  * |--------+------+------+------+------+-------------|           |------+------+------+------+------+------+--------|
  * |        |      |      | MsUp |      |      |      |           |      |      |      |      |      |      |        |
  * |--------+------+------+------+------+------|      |           |      |------+------+------+------+------+--------|
@@ -257,7 +295,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
  */
 // MEDIA AND MOUSE
 [MDIA] = LAYOUT_ergodox(
-       KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,
+       KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, HOST_OS, LAYER_STATS,
        KC_TRNS, KC_TRNS, KC_TRNS, KC_MS_U, KC_TRNS, KC_TRNS, KC_TRNS,
        KC_TRNS, KC_TRNS, KC_MS_L, KC_MS_D, KC_MS_R, KC_TRNS,
        KC_TRNS, KC_TRNS, KC_TRNS, KC_BTN1, KC_BTN2, KC_TRNS, KC_TRNS,
@@ -298,18 +336,18 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
  */
 // PROGRAMMUNICATION
 [PROG] = LAYOUT_ergodox(
-       KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, SE_SLSH, SE_BSLS, SE_ASTR,
+       KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, SE_SLSH, HS_BSLS, SE_ASTR,
        SE_DQUO, KC_COPY, KC_PSTE, SE_LPRN, SE_RPRN, SE_EQL, SE_MINS,
-       SE_QUOT, PE_GRAV, KC_CUT, SE_LBRC, SE_RBRC, SE_COLN,
-       KC_TRNS, SE_HASH, PE_RARR, SE_LCBR, SE_RCBR, SE_SCLN, SE_UNDS,
-       KC_TRNS, KC_TRNS, KC_TRNS, SE_LABK, SE_RABK,
+       SE_QUOT, PE_GRAV, KC_CUT, HS_LBRC, HS_RBRC, SE_COLN,
+       KC_TRNS, SE_HASH, PE_RARR, HS_LCBR, HS_RCBR, SE_SCLN, SE_UNDS,
+       KC_TRNS, KC_TRNS, KC_TRNS, HS_LABK, HS_RABK,
                                            KC_TRNS, KC_TRNS,
                                                     KC_TRNS,
                                   KC_TRNS, KC_TRNS, KC_TRNS,
     // right hand
        KC_TRNS,  KC_TRNS, KC_TRNS, KC_TRNS, TO(VIM), TO(BASE), KC_TRNS,
-       KC_TRNS,  SE_PIPE, SE_LCBR, SE_RCBR, SE_EXLM, SE_QUES, SE_DLR,
-                 SE_SCLN, SE_LABK, SE_RABK, SE_HASH, SE_PERC, SE_AMPR,
+       KC_TRNS,  HS_PIPE, HS_LCBR, HS_RCBR, SE_EXLM, SE_QUES, HS_DLR,
+                 SE_SCLN, HS_LABK, HS_RABK, SE_HASH, SE_PERC, SE_AMPR,
        KC_TRNS,  KC_TRNS, SE_MINS, SE_PLUS, SE_CIRC, KC_TRNS, KC_TRNS,
                           KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,
        KC_TRNS, KC_TRNS,
@@ -359,11 +397,74 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 ),
 };
 
+// Right hand LEDs lit for each layer, bit n is LED n.
+static const uint8_t layer_indicators[LAYER_COUNT] PROGMEM = {
+    [BASE] = 0,
+    [SYMB] = 1 << 1,
+    [MDIA] = 1 << 2,
+    [PROG] = 1 << 3,
+    [VIM]  = 1 << 1 | 1 << 2,
+};
+
+static void set_layer_indicator(uint8_t layer) {
+    uint8_t leds = pgm_read_byte(&layer_indicators[layer]);
+
+    ergodox_board_led_off();
+    for (uint8_t led = 1; led <= 3; led++) {
+        if (leds & (1 << led)) {
+            ergodox_right_led_on(led);
+        } else {
+            ergodox_right_led_off(led);
+        }
+    }
+}
+
+static uint8_t current_layer = BASE;
+
+#ifdef LAYER_METRICS_ENABLE
+// Layer metrics since power on, for tuning the layout.
+static uint32_t layer_entered;
+static uint32_t layer_time[LAYER_COUNT]; // ms spent on each layer
+static uint16_t layer_transitions[LAYER_COUNT][LAYER_COUNT]; // [from][to]
+
+// Prints one line per layer to the console (qmk console):
+// "<layer>: <ms> ms, to <count> <count> ...".
+static void print_layer_stats(void) {
+    for (uint8_t from = 0; from < LAYER_COUNT; from++) {
+        uint32_t time = layer_time[from];
+        if (from == current_layer) {
+            time += timer_elapsed32(layer_entered);
+        }
+
+        uprintf("%u: %lu ms, to", from, time);
+        for (uint8_t to = 0; to < LAYER_COUNT; to++) {
+            uprintf(" %u", layer_transitions[from][to]);
+        }
+        uprintf("\n");
+    }
+}
+#endif
+
 // Runs just one time when the keyboard initializes.
 void matrix_init_user(void) {
 
 }
 
+void keyboard_post_init_user(void) {
+    user_config.raw = eeconfig_read_user();
+    set_host_os(user_config.host_os);
+#ifdef LAYER_METRICS_ENABLE
+    layer_entered = timer_read32();
+#endif
+    set_layer_indicator(BASE);
+}
+
+// Runs when the EEPROM is reset.
+void eeconfig_init_user(void) {
+    user_config.raw = 0;
+    eeconfig_update_user(user_config.raw);
+}
+
 // Combos
 enum combos {
     QW_ESC,
@@ -392,18 +493,56 @@ combo_t key_combos[] = {
     [QW_ESC] = COMBO(combo_qw_esc, KC_ESC),
     [YU_LPAREN] = COMBO(combo_yu_lparen, SE_LPRN),
     [UI_RPAREN] = COMBO(combo_ui_rparen, SE_RPRN),
-    [HJ_LBRACE] = COMBO(combo_hj_lbracket, SE_LCBR),
-    [JK_RBRACE] = COMBO(combo_jk_rbracket, SE_RCBR),
-    [ER_LBRACKET] = COMBO(combo_er_lbracket, SE_LBRC),
-    [RT_RBRACKET] = COMBO(combo_rt_rbracket, SE_RBRC),
-    [DF_LANGLE] = COMBO(combo_df_langle, SE_LABK),
-    [FG_RANGLE] = COMBO(combo_fg_rangle, SE_RABK),
+    [HJ_LBRACE] = COMBO(combo_hj_lbracket, HS_LCBR),
+    [JK_RBRACE] = COMBO(combo_jk_rbracket, HS_RCBR),
+    [ER_LBRACKET] = COMBO(combo_er_lbracket, HS_LBRC),
+    [RT_RBRACKET] = COMBO(combo_rt_rbracket, HS_RBRC),
+    [DF_LANGLE] = COMBO(combo_df_langle, HS_LABK),
+    [FG_RANGLE] = COMBO(combo_fg_rangle, HS_RABK),
 };
 
+// Blinks right hand LED 3 once for Mac or twice for PC, driven from
+// matrix_scan_user. Layer LEDs are off meanwhile and restored afterwards.
+#define HOST_OS_BLINK_MS 150
+
+static uint8_t  host_os_blink_steps; // LED toggles left
+static uint16_t host_os_blink_timer;
+
+static void show_host_os(void) {
+    ergodox_right_led_off(1);
+    ergodox_right_led_off(2);
+    ergodox_right_led_on(3);
+    host_os_blink_steps = (user_config.host_os + 1) * 2 - 1;
+    host_os_blink_timer = timer_read();
+}
+
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
     mod_state = get_mods();
 
   switch (keycode) {
+    case HOST_OS:
+        if (record->event.pressed) {
+            set_host_os((user_config.host_os + 1) % HOST_COUNT);
+            eeconfig_update_user(user_config.raw);
+            show_host_os();
+        }
+        return false;
+#ifdef LAYER_METRICS_ENABLE
+    case LAYER_STATS:
+        if (record->event.pressed) {
+            print_layer_stats();
+        }
+        return false;
+#endif
+    case HS_DLR ... HS_RABK:
+        if (record->event.pressed) {
+            uint8_t c = pgm_read_byte(&host_symbols[HOST_SYMBOL(keycode)]);
+            held_symbols[HOST_SYMBOL(keycode)] = pgm_read_word(&host_profile->ascii[c]);
+            register_ascii_entry(held_symbols[HOST_SYMBOL(keycode)]);
+        } else {
+            unregister_ascii_entry(held_symbols[HOST_SYMBOL(keycode)]);
+        }
+        return false;
     case PE_TILD:
         if (record->event.pressed) {
             SEND_STRING("~");
@@ -458,35 +597,42 @@ const key_override_t **key_overrides = (const key_override_t *[]){
     NULL // Null terminate the array of overrides!
 };
 
-// Runs constantly in the background, in a loop.
-void matrix_scan_user(void) {
+// Runs whenever there is a layer state change.
+layer_state_t layer_state_set_user(layer_state_t state) {
+    uint8_t layer = get_highest_layer(state);
+    if (layer >= LAYER_COUNT) {
+        layer = BASE;
+    }
+    if (layer == current_layer) {
+        return state;
+    }
 
-    uint8_t layer = biton32(layer_state);
+#ifdef LAYER_METRICS_ENABLE
+    layer_time[current_layer] += timer_elapsed32(layer_entered);
+    layer_entered = timer_read32();
+    if (layer_transitions[current_layer][layer] < UINT16_MAX) {
+        layer_transitions[current_layer][layer]++;
+    }
+#endif
 
-    ergodox_board_led_off();
-    ergodox_right_led_1_off();
-    ergodox_right_led_2_off();
-    ergodox_right_led_3_off();
-    switch (layer) {
-        case 1:
-            ergodox_right_led_1_on();
-            break;
-        case 2:
-            ergodox_right_led_2_on();
-            break;
-        case 3:
-            ergodox_right_led_3_on();
-            break;
-        case 4:
-            ergodox_right_led_1_on();
-            ergodox_right_led_2_on();
-            break;
-        case 5:
-            ergodox_right_led_1_on();
-            ergodox_right_led_3_on();
-        default:
-            // none
-            break;
+    current_layer = layer;
+    if (!host_os_blink_steps) {
+        set_layer_indicator(layer);
     }
+    return state;
+}
 
-};
+// Runs constantly in the background, in a loop.
+void matrix_scan_user(void) {
+    if (host_os_blink_steps && timer_elapsed(host_os_blink_timer) > HOST_OS_BLINK_MS) {
+        host_os_blink_timer = timer_read();
+        host_os_blink_steps--;
+        if (!host_os_blink_steps) {
+            set_layer_indicator(current_layer);
+        } else if (host_os_blink_steps % 2) {
+            ergodox_right_led_on(3);
+        } else {
+            ergodox_right_led_off(3);
+        }
+    }
+}
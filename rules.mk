@@ -1,3 +1,20 @@
 KEY_OVERRIDE_ENABLE = yes
-TAPPING_TOGGLE = 2
 COMBO_ENABLE = yes
+# Set to yes together with LAYER_METRICS_ENABLE in config.h
+CONSOLE_ENABLE = no
+
+# Type every SEND_STRING table entry on a simulated host layout before
+# building, see ascii_layouts_verify.c. A bad table stops the build.
+# Skipped for clean targets.
+ifeq ($(filter clean distclean,$(MAKECMDGOALS)),)
+    ifeq ($(shell command -v cc),)
+        $(error ascii_layouts_verify.c needs a host C compiler, no cc found on PATH)
+    endif
+    ASCII_LAYOUTS_DIR := $(dir $(lastword $(MAKEFILE_LIST)))
+    ASCII_LAYOUTS_RESULT := $(shell bin=$$(mktemp) && \
+        cc -o $$bin $(ASCII_LAYOUTS_DIR)ascii_layouts_verify.c 2>&1 && $$bin 2>&1; \
+        status=$$?; rm -f $$bin; [ $$status -eq 0 ] || echo ASCII_LAYOUTS_FAILED)
+    ifneq ($(filter ASCII_LAYOUTS_FAILED,$(ASCII_LAYOUTS_RESULT)),)
+        $(error ascii_layouts_verify failed: $(ASCII_LAYOUTS_RESULT))
+    endif
+endif